@@ -0,0 +1,310 @@
+//
+//  ReportPlans.cpp
+//  WheelSupportTools
+//
+
+#include <CoreFoundation/CFData.h>
+#include <stdio.h>
+#include <string.h>
+#include "ReportPlans.h"
+
+//=============================================================================
+// HID short item types and tags (HID 1.11, section 6.2.2)
+#define kHIDItemTypeMain							0
+#define kHIDItemTypeGlobal							1
+#define kHIDItemTypeLocal							2
+#define kHIDItemLong								0xfe
+
+#define kHIDMainInput								0x8
+
+#define kHIDGlobalUsagePage							0x0
+#define kHIDGlobalLogicalMin						0x1
+#define kHIDGlobalLogicalMax						0x2
+#define kHIDGlobalReportSize						0x7
+#define kHIDGlobalReportID							0x8
+#define kHIDGlobalReportCount						0x9
+#define kHIDGlobalPush								0xa
+#define kHIDGlobalPop								0xb
+
+#define kHIDLocalUsage								0x0
+#define kHIDLocalUsageMin							0x1
+#define kHIDLocalUsageMax							0x2
+
+#define kHIDInputConstant							0x01
+#define kHIDInputVariable							0x02
+
+#define kHIDGlobalStackMax							4
+
+struct CGlobalState
+{
+	UInt16 usagePage;
+	SInt32 logicalMin;
+	SInt32 logicalMax;
+	UInt32 reportSize;
+	UInt32 reportCount;
+	UInt8 reportID;
+};
+
+static bool ParseReportDescriptor(CReportPlan *plan, const UInt8 *descriptor, CFIndex length);
+
+
+
+//=============================================================================
+//		GetReportPlan : Build the input report layout of the device from its
+//						report descriptor
+//-----------------------------------------------------------------------------
+bool GetReportPlan(IOHIDDeviceRef hidDevice, DeviceID deviceID, CReportPlan *plan)
+{
+	CFTypeRef dataRef = IOHIDDeviceGetProperty(hidDevice, CFSTR(kIOHIDReportDescriptorKey));
+	if(!dataRef || (CFDataGetTypeID() != CFGetTypeID(dataRef)))
+	{
+		return false;
+	}
+
+	const UInt8 *descriptor = CFDataGetBytePtr((CFDataRef)dataRef);
+	CFIndex length = CFDataGetLength((CFDataRef)dataRef);
+	if(!BuildReportPlan(plan, descriptor, length))
+	{
+		printf("WARNING: Unable to parse report descriptor. (VendorID/DeviceID %x)\n", deviceID);
+		return false;
+	}
+	return true;
+}
+
+
+
+//=============================================================================
+//		HashReportDescriptor : FNV-1a hash of the raw descriptor bytes
+//-----------------------------------------------------------------------------
+UInt32 HashReportDescriptor(const UInt8 *descriptor, CFIndex length)
+{
+	UInt32 hash = 0x811c9dc5;
+	for(CFIndex i = 0; i < length; ++i)
+	{
+		hash ^= descriptor[i];
+		hash *= 0x01000193;
+	}
+	return hash;
+}
+
+
+
+//=============================================================================
+//		BuildReportPlan : Walk the report descriptor once and record the
+//						  position of every input field
+//						  On failure the plan is left empty
+//-----------------------------------------------------------------------------
+bool BuildReportPlan(CReportPlan *plan, const UInt8 *descriptor, CFIndex length)
+{
+	memset(plan, 0, sizeof(CReportPlan));
+	if(!ParseReportDescriptor(plan, descriptor, length))
+	{
+		memset(plan, 0, sizeof(CReportPlan));
+		return false;
+	}
+	plan->descriptorHash = HashReportDescriptor(descriptor, length);
+	return true;
+}
+
+
+
+//=============================================================================
+//		ParseReportDescriptor : Short item walker behind BuildReportPlan
+//-----------------------------------------------------------------------------
+static bool ParseReportDescriptor(CReportPlan *plan, const UInt8 *descriptor, CFIndex length)
+{
+	CGlobalState globals;
+	CGlobalState stack[kHIDGlobalStackMax];
+	int stackDepth = 0;
+	memset(&globals, 0, sizeof(globals));
+
+	// Usages keep their page in the upper 16 bits, or 0 for the current Usage Page
+	UInt32 usages[kGPReportUsagesMax];
+	int usageCount = 0;
+	UInt32 usageMin = 0;
+	UInt32 usageMax = 0;
+	bool hasUsageRange = false;
+
+	// Input bit offset reached so far in each report
+	UInt32 reportBits[256];
+	memset(reportBits, 0, sizeof(reportBits));
+	bool usesReportIDs = false;
+
+	CFIndex i = 0;
+	while(i < length)
+	{
+		UInt8 prefix = descriptor[i];
+
+		// Long items carry nothing we use; skip over them
+		if(prefix == kHIDItemLong)
+		{
+			if(i + 1 >= length || i + 3 + descriptor[i + 1] > length)
+			{
+				return false;
+			}
+			i += 3 + descriptor[i + 1];
+			continue;
+		}
+
+		int size = prefix & 0x3;
+		if(size == 3)
+		{
+			size = 4;
+		}
+		int type = (prefix >> 2) & 0x3;
+		int tag = (prefix >> 4) & 0xf;
+
+		if(i + 1 + size > length)
+		{
+			return false;
+		}
+
+		UInt32 data = 0;
+		for(int b = 0; b < size; ++b)
+		{
+			data |= (UInt32)descriptor[i + 1 + b] << (8 * b);
+		}
+
+		// Logical extents are signed in the size they were encoded with
+		SInt32 sdata = (SInt32)data;
+		if(size == 1)
+		{
+			sdata = (SInt8)data;
+		}
+		else if(size == 2)
+		{
+			sdata = (SInt16)data;
+		}
+
+		// Only 4-byte usages carry their own usage page
+		UInt32 usage = (size == 4) ? data : (data & 0xffff);
+
+		i += 1 + size;
+
+		if(type == kHIDItemTypeGlobal)
+		{
+			switch(tag)
+			{
+				case kHIDGlobalUsagePage:	globals.usagePage = data; break;
+				case kHIDGlobalLogicalMin:	globals.logicalMin = sdata; break;
+				case kHIDGlobalLogicalMax:	globals.logicalMax = sdata; break;
+				case kHIDGlobalReportSize:	globals.reportSize = data; break;
+				case kHIDGlobalReportCount:	globals.reportCount = data; break;
+				case kHIDGlobalReportID:
+					globals.reportID = data;
+					usesReportIDs = true;
+					break;
+				case kHIDGlobalPush:
+					if(stackDepth == kHIDGlobalStackMax)
+					{
+						return false;
+					}
+					stack[stackDepth++] = globals;
+					break;
+				case kHIDGlobalPop:
+					if(stackDepth == 0)
+					{
+						return false;
+					}
+					globals = stack[--stackDepth];
+					break;
+			}
+		}
+		else if(type == kHIDItemTypeLocal)
+		{
+			switch(tag)
+			{
+				case kHIDLocalUsage:
+					if(usageCount < kGPReportUsagesMax)
+					{
+						usages[usageCount++] = usage;
+					}
+					break;
+				case kHIDLocalUsageMin:
+					usageMin = usage;
+					hasUsageRange = true;
+					break;
+				case kHIDLocalUsageMax:
+					usageMax = usage;
+					hasUsageRange = true;
+					break;
+			}
+		}
+		else if(type == kHIDItemTypeMain)
+		{
+			if(tag == kHIDMainInput)
+			{
+				// Reject items that would run past the largest report we can index
+				UInt32 bitBase = (usesReportIDs ? 8 : 0) + reportBits[globals.reportID];
+				UInt64 bitCount = (UInt64)globals.reportCount * globals.reportSize;
+				if(bitBase + bitCount > kGPReportBitsMax)
+				{
+					return false;
+				}
+				reportBits[globals.reportID] += (UInt32)bitCount;
+
+				bool padding = (data & kHIDInputConstant) || !(data & kHIDInputVariable);
+				if(!padding && globals.reportSize > 0 && globals.reportSize <= 32)
+				{
+					// Count every field, even those past the end of fields[]
+					for(UInt32 n = 0; n < globals.reportCount; ++n)
+					{
+						UInt32 bitOffset = bitBase + n * globals.reportSize;
+
+						// Later fields reuse the last usage when the list runs short
+						UInt32 fieldUsage = 0;
+						if(hasUsageRange)
+						{
+							fieldUsage = (usageMin + n <= usageMax) ? usageMin + n : usageMax;
+						}
+						else if(usageCount > 0)
+						{
+							fieldUsage = usages[n < (UInt32)usageCount ? n : usageCount - 1];
+						}
+						UInt16 usagePage = (fieldUsage >> 16) ? (fieldUsage >> 16) : globals.usagePage;
+						UInt16 usageID = fieldUsage & 0xffff;
+
+						if(usagePage == kGPUsagePageButton)
+						{
+							plan->buttons++;
+						}
+						else if(usagePage == kGPUsagePageGenericDesktop)
+						{
+							if(usageID >= kGPUsageAxisFirst && usageID <= kGPUsageAxisLast)
+							{
+								plan->axes++;
+							}
+							else if(usageID == kGPUsageHatSwitch)
+							{
+								plan->hats++;
+							}
+						}
+
+						if(plan->count == kGPReportFieldsMax)
+						{
+							continue;
+						}
+
+						CReportField *field = &plan->fields[plan->count++];
+						field->usagePage = usagePage;
+						field->usage = usageID;
+						field->reportID = globals.reportID;
+						field->byteOffset = bitOffset >> 3;
+						field->shift = bitOffset & 0x7;
+						field->mask = globals.reportSize == 32 ? 0xffffffff : (1u << globals.reportSize) - 1;
+						field->logicalMin = globals.logicalMin;
+						field->logicalMax = globals.logicalMax;
+					}
+				}
+			}
+
+			// Local items only apply to the main item that follows them
+			usageCount = 0;
+			hasUsageRange = false;
+			usageMin = 0;
+			usageMax = 0;
+		}
+	}
+
+	return true;
+}
@@ -0,0 +1,71 @@
+//
+//  ReportPlans.h
+//  WheelSupportTools
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program.  If not, see <http://www.gnu.org/licenses/>.
+//
+
+#ifndef __WheelSupportTools__ReportPlans__
+#define __WheelSupportTools__ReportPlans__
+
+#include <IOKit/hid/IOHIDManager.h>
+#include "WheelSupports.h"
+
+
+// HID usage pages and usages we care about
+#define kGPUsagePageGenericDesktop					0x01
+#define kGPUsagePageButton							0x09
+#define kGPUsageAxisFirst							0x30
+#define kGPUsageAxisLast							0x38
+#define kGPUsageHatSwitch							0x39
+
+// Plan limits
+#define kGPReportFieldsMax							64
+#define kGPReportUsagesMax							16
+#define kGPReportBitsMax							(0xff * 8)
+
+//=============================================================================
+// A single input field, located by byte offset, shift and mask
+struct CReportField
+{
+	UInt16 usagePage;
+	UInt16 usage;
+	UInt8 reportID;
+	UInt8 byteOffset;
+	UInt8 shift;
+	UInt32 mask;
+	SInt32 logicalMin;
+	SInt32 logicalMax;
+};
+
+// Input report layout of a device. Restricted and native mode report
+// differently, so the descriptor hash identifies which layout is current.
+// The counts cover every input field, including any that did not fit in fields.
+struct CReportPlan
+{
+	UInt32 descriptorHash;
+	CReportField fields[kGPReportFieldsMax];
+	UInt8 count;
+	UInt16 axes;
+	UInt16 buttons;
+	UInt16 hats;
+};
+
+//=============================================================================
+bool GetReportPlan(IOHIDDeviceRef hidDevice, DeviceID deviceID, CReportPlan *plan);
+
+UInt32 HashReportDescriptor(const UInt8 *descriptor, CFIndex length);
+bool BuildReportPlan(CReportPlan *plan, const UInt8 *descriptor, CFIndex length);
+
+#endif /* defined(__WheelSupportTools__ReportPlans__) */
@@ -0,0 +1,185 @@
+//
+//  ReportPlansCheck.cpp
+//  WheelSupportTools
+//
+//  Checks the report descriptor parser against known descriptors.
+//  Build and run with `make check`.
+//
+
+#include <assert.h>
+#include <stdio.h>
+#include "ReportPlans.h"
+
+//=============================================================================
+// Corrected Driving Force Pro descriptor that the Linux hid-lg driver
+// substitutes for the broken one the wheel reports (dfp_rdesc_fixed).
+// This exercises the parser; it is not what --info reads from a real DFP.
+static const UInt8 sDFPFixedDescriptor[] =
+{
+	0x05, 0x01,			// Usage Page (Desktop)
+	0x09, 0x04,			// Usage (Joystick)
+	0xa1, 0x01,			// Collection (Application)
+	0xa1, 0x02,			//   Collection (Logical)
+	0x95, 0x01,			//     Report Count (1)
+	0x75, 0x0e,			//     Report Size (14)
+	0x14,				//     Logical Minimum (0)
+	0x26, 0xff, 0x3f,	//     Logical Maximum (16383)
+	0x34,				//     Physical Minimum (0)
+	0x46, 0xff, 0x3f,	//     Physical Maximum (16383)
+	0x09, 0x30,			//     Usage (X)
+	0x81, 0x02,			//     Input (Variable)
+	0x95, 0x0e,			//     Report Count (14)
+	0x75, 0x01,			//     Report Size (1)
+	0x25, 0x01,			//     Logical Maximum (1)
+	0x45, 0x01,			//     Physical Maximum (1)
+	0x05, 0x09,			//     Usage Page (Button)
+	0x19, 0x01,			//     Usage Minimum (01h)
+	0x29, 0x0e,			//     Usage Maximum (0Eh)
+	0x81, 0x02,			//     Input (Variable)
+	0x05, 0x01,			//     Usage Page (Desktop)
+	0x95, 0x01,			//     Report Count (1)
+	0x75, 0x04,			//     Report Size (4)
+	0x25, 0x07,			//     Logical Maximum (7)
+	0x46, 0x3b, 0x01,	//     Physical Maximum (315)
+	0x65, 0x14,			//     Unit (Degrees)
+	0x09, 0x39,			//     Usage (Hat Switch)
+	0x81, 0x42,			//     Input (Variable, Null State)
+	0x65, 0x00,			//     Unit
+	0x26, 0xff, 0x00,	//     Logical Maximum (255)
+	0x46, 0xff, 0x00,	//     Physical Maximum (255)
+	0x75, 0x08,			//     Report Size (8)
+	0x81, 0x01,			//     Input (Constant)
+	0x09, 0x31,			//     Usage (Y)
+	0x81, 0x02,			//     Input (Variable)
+	0x09, 0x35,			//     Usage (Rz)
+	0x81, 0x02,			//     Input (Variable)
+	0x81, 0x01,			//     Input (Constant)
+	0xc0,				//   End Collection
+	0xa1, 0x02,			//   Collection (Logical)
+	0x09, 0x02,			//     Usage (02h)
+	0x95, 0x07,			//     Report Count (7)
+	0x91, 0x02,			//     Output (Variable)
+	0xc0,				//   End Collection
+	0xc0				// End Collection
+};
+
+// Report ID, signed axis and a 4-byte usage carrying its own usage page
+static const UInt8 sSignedDescriptor[] =
+{
+	0x05, 0x01,			// Usage Page (Desktop)
+	0x85, 0x02,			// Report ID (2)
+	0x09, 0x30,			// Usage (X)
+	0x15, 0x81,			// Logical Minimum (-127)
+	0x25, 0x7f,			// Logical Maximum (127)
+	0x75, 0x08,			// Report Size (8)
+	0x95, 0x01,			// Report Count (1)
+	0x81, 0x02,			// Input (Variable)
+	0x0b, 0x05, 0x00, 0x09, 0x00,	// Usage (Button 5)
+	0x15, 0x00,			// Logical Minimum (0)
+	0x25, 0x01,			// Logical Maximum (1)
+	0x75, 0x01,			// Report Size (1)
+	0x81, 0x02,			// Input (Variable)
+};
+
+// 100 buttons, more than fit in the plan's field table
+static const UInt8 sManyButtonsDescriptor[] =
+{
+	0x05, 0x09,			// Usage Page (Button)
+	0x19, 0x01,			// Usage Minimum (01h)
+	0x29, 0x64,			// Usage Maximum (64h)
+	0x15, 0x00,			// Logical Minimum (0)
+	0x25, 0x01,			// Logical Maximum (1)
+	0x75, 0x01,			// Report Size (1)
+	0x95, 0x64,			// Report Count (100)
+	0x81, 0x02,			// Input (Variable)
+};
+
+// Long item whose declared data runs past the end of the descriptor
+static const UInt8 sTruncatedLongDescriptor[] =
+{
+	0xfe, 0x40, 0x00,	// Long Item (64 data bytes, none present)
+};
+
+// Report Count (0xffffffff) must be rejected rather than walked
+static const UInt8 sHugeCountDescriptor[] =
+{
+	0x05, 0x09,			// Usage Page (Button)
+	0x19, 0x01,			// Usage Minimum (01h)
+	0x29, 0x08,			// Usage Maximum (08h)
+	0x75, 0x01,			// Report Size (1)
+	0x97, 0xff, 0xff, 0xff, 0xff,	// Report Count (0xffffffff)
+	0x81, 0x02,			// Input (Variable)
+};
+
+
+
+//=============================================================================
+//		CheckField : Assert the location and extents of one field
+//-----------------------------------------------------------------------------
+static void CheckField(const CReportField *field, UInt16 usagePage, UInt16 usage, UInt8 byteOffset, UInt8 shift, UInt32 mask)
+{
+	assert(field->usagePage == usagePage);
+	assert(field->usage == usage);
+	assert(field->byteOffset == byteOffset);
+	assert(field->shift == shift);
+	assert(field->mask == mask);
+}
+
+
+
+//=============================================================================
+//		main
+//-----------------------------------------------------------------------------
+int main()
+{
+	CReportPlan plan;
+	bool built;
+
+	// Fixed DFP: X(14) buttons(14) hat(4) pad(8) Y(8) Rz(8) pad(8)
+	built = BuildReportPlan(&plan, sDFPFixedDescriptor, sizeof(sDFPFixedDescriptor));
+	assert(built);
+	assert(plan.count == 1 + 14 + 1 + 2);
+	assert(plan.axes == 3);
+	assert(plan.buttons == 14);
+	assert(plan.hats == 1);
+	CheckField(&plan.fields[0], kGPUsagePageGenericDesktop, 0x30, 0, 0, 0x3fff);
+	CheckField(&plan.fields[1], kGPUsagePageButton, 1, 1, 6, 0x1);
+	CheckField(&plan.fields[14], kGPUsagePageButton, 14, 3, 3, 0x1);
+	CheckField(&plan.fields[15], kGPUsagePageGenericDesktop, kGPUsageHatSwitch, 3, 4, 0xf);
+	CheckField(&plan.fields[16], kGPUsagePageGenericDesktop, 0x31, 5, 0, 0xff);
+	CheckField(&plan.fields[17], kGPUsagePageGenericDesktop, 0x35, 6, 0, 0xff);
+	assert(plan.fields[0].logicalMax == 0x3fff);
+	assert(plan.fields[0].reportID == 0);
+
+	// Report ID byte shifts every field; logical extents keep their sign
+	built = BuildReportPlan(&plan, sSignedDescriptor, sizeof(sSignedDescriptor));
+	assert(built);
+	assert(plan.count == 2);
+	CheckField(&plan.fields[0], kGPUsagePageGenericDesktop, 0x30, 1, 0, 0xff);
+	assert(plan.fields[0].reportID == 2);
+	assert(plan.fields[0].logicalMin == -127);
+	assert(plan.fields[0].logicalMax == 127);
+	CheckField(&plan.fields[1], kGPUsagePageButton, 5, 2, 0, 0x1);
+	assert(plan.axes == 1 && plan.buttons == 1);
+
+	// Fields past the end of the table are still counted
+	built = BuildReportPlan(&plan, sManyButtonsDescriptor, sizeof(sManyButtonsDescriptor));
+	assert(built);
+	assert(plan.count == kGPReportFieldsMax);
+	assert(plan.buttons == 100);
+	CheckField(&plan.fields[kGPReportFieldsMax - 1], kGPUsagePageButton, kGPReportFieldsMax, 7, 7, 0x1);
+
+	// Malformed or truncated descriptors leave an empty plan behind
+	built = BuildReportPlan(&plan, sHugeCountDescriptor, sizeof(sHugeCountDescriptor));
+	assert(!built);
+	assert(plan.count == 0 && plan.axes == 0 && plan.buttons == 0 && plan.hats == 0);
+	built = BuildReportPlan(&plan, sDFPFixedDescriptor, 14);
+	assert(!built);
+	assert(plan.count == 0 && plan.axes == 0 && plan.buttons == 0 && plan.hats == 0);
+	built = BuildReportPlan(&plan, sTruncatedLongDescriptor, sizeof(sTruncatedLongDescriptor));
+	assert(!built);
+	assert(plan.count == 0 && plan.axes == 0 && plan.buttons == 0 && plan.hats == 0);
+
+	printf("ReportPlans checks passed.\n");
+	return 0;
+}
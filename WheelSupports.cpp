@@ -9,6 +9,7 @@
 #include <CoreFoundation/CFString.h>
 #include <string>
 #include "WheelSupports.h"
+#include "ReportPlans.h"
 
 //=============================================================================
 // Mode strings
@@ -219,6 +220,13 @@ bool ConfigLogitechWheels(IOHIDDeviceRef hidDevice, DeviceID deviceID, bool nati
 		CFStringGetCString(productID, sProductID, 256, kCFStringEncodingASCII);
 
 		printf("Device ID=%x   Product ID=%s (%s)\n", deviceID, sProductID, mode);
+
+		// Report layouts differ between restricted and native mode, so describe the current one
+		CReportPlan plan;
+		if(GetReportPlan(hidDevice, deviceID, &plan))
+		{
+			printf("    Input report: %d axes, %d buttons, %d hats (descriptor %08x)\n", plan.axes, plan.buttons, plan.hats, plan.descriptorHash);
+		}
 		return false;
 	}
 	